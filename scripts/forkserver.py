@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+"""Python fork server for `sandbox --fork-server`.
+
+Usage (inside the sandbox):
+    forkserver.py [WARMUP.py ...]
+
+Runs each WARMUP script once (e.g. to pre-import modules), then reads job
+requests from the fd named by SANDBOX_FORKSERVER_FD. Each line is a script
+path plus arguments; it is run in a forked child and its exit status is
+written back as "exit N" or "signal N". A line that cannot be parsed into a
+script path is answered with "error bad-request" and nothing is run. A
+script that cannot be opened exits with status 2, as with python3.
+
+Jobs run like `python3 JOB.py ARGS` with two differences: stdin is always
+at EOF (the sandbox reads job requests from its own stdin), and the
+interpreter state left behind by the warm-up is inherited.
+
+Non-daemon threads started by a job are joined and atexit handlers
+registered by a job run when the job exits. Handlers
+registered by warm-up scripts are not run in jobs; they run once, when
+the server itself exits.
+"""
+import atexit
+import os
+# runpy.run_path() imports pkgutil lazily; import it here so forked jobs
+# don't each pay for it
+import pkgutil  # noqa: F401
+import runpy
+import shlex
+import sys
+import traceback
+
+FD_ENV = "SANDBOX_FORKSERVER_FD"
+
+
+def open_failure(path):
+    """Return the error python3 prints for an unopenable script, or None."""
+    if os.path.isdir(path):
+        return None
+    try:
+        with open(path, "rb"):
+            pass
+    except OSError as e:
+        return (f"{sys.executable}: can't open file {os.path.abspath(path)!r}: "
+                f"[Errno {e.errno}] {e.strerror}")
+    return None
+
+
+def run_job(sock_fd, argv):
+    os.close(sock_fd)
+    # Warm-up exit handlers belong to the server, not to each job
+    atexit._clear()
+    error = open_failure(argv[0])
+    if error is not None:
+        print(error, file=sys.stderr)
+        sys.stderr.flush()
+        os._exit(2)
+    code = 0
+    try:
+        sys.argv = argv
+        sys.path[0] = os.path.dirname(os.path.abspath(argv[0]))
+        runpy.run_path(argv[0], run_name="__main__")
+    except SystemExit as e:
+        if e.code is None:
+            code = 0
+        elif isinstance(e.code, int):
+            code = e.code
+        else:
+            print(e.code, file=sys.stderr)
+            code = 1
+    except BaseException:
+        traceback.print_exc()
+        code = 1
+    # os._exit() skips interpreter shutdown, so wait for the job's
+    # non-daemon threads here the way python3 does before exiting
+    threading = sys.modules.get("threading")
+    if threading is not None:
+        threading._shutdown()
+    atexit._run_exitfuncs()
+    try:
+        sys.stdout.flush()
+        sys.stderr.flush()
+    except BaseException:
+        pass
+    os._exit(code & 0xff)
+
+
+def serve(sock_fd):
+    requests = os.fdopen(sock_fd, "rb", closefd=False)
+    for raw in requests:
+        try:
+            # Decode like sys.argv so non-UTF-8 arguments reach the job
+            argv = shlex.split(os.fsdecode(raw))
+        except ValueError as e:
+            print(f"forkserver: bad job request: {e}", file=sys.stderr)
+            argv = []
+
+        if not argv or not argv[0]:
+            reply = "error bad-request"
+        else:
+            sys.stdout.flush()
+            sys.stderr.flush()
+            pid = os.fork()
+            if pid == 0:
+                run_job(sock_fd, argv)
+            _, status = os.waitpid(pid, 0)
+            if os.WIFSIGNALED(status):
+                reply = f"signal {os.WTERMSIG(status)}"
+            else:
+                reply = f"exit {os.WEXITSTATUS(status)}"
+
+        os.write(sock_fd, (reply + "\n").encode())
+
+
+def main():
+    fd = os.environ.get(FD_ENV)
+    if fd is None:
+        print(f"forkserver: {FD_ENV} not set, run via sandbox --fork-server",
+              file=sys.stderr)
+        return 1
+
+    for warmup in sys.argv[1:]:
+        runpy.run_path(warmup, run_name="__warmup__")
+
+    serve(int(fd))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
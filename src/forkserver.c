@@ -0,0 +1,242 @@
+#include "sandbox.h"
+
+// Fork-server protocol (line based, over a socketpair):
+//   supervisor -> server: one job per line, e.g. "job.py arg1 arg2"
+//   server -> supervisor: one status per job, "exit N", "signal N" or
+//                         "error REASON" if the request was not run
+// The server itself runs under the same Landlock + seccomp policy as a
+// normal sandboxed executable; jobs are forked from it and inherit that.
+
+// Returns the line length, -1 on EOF/error, or -2 if the line did not fit
+// in buf (the rest of it is consumed so the next read starts in sync)
+static int read_line(int fd, char *buf, size_t size) {
+    size_t len = 0;
+    int overflow = 0;
+
+    for (;;) {
+        char c;
+        ssize_t n = read(fd, &c, 1);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (n == 0) {
+            break;
+        }
+        if (c == '\n') {
+            buf[len] = '\0';
+            return overflow ? -2 : (int)len;
+        }
+        if (len < size - 1) {
+            buf[len++] = c;
+        } else {
+            overflow = 1;
+        }
+    }
+
+    buf[len] = '\0';
+    return -1;
+}
+
+static int write_all(int fd, const char *buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = send(fd, buf, len, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static void start_server(struct sandbox_config *config, int server_fd) {
+    char fd_str[16];
+    int stdin_pipe[2];
+
+    // Job requests arrive on the supervisor's stdin, so give the server
+    // (and every job it forks) an empty stdin instead
+    if (pipe(stdin_pipe) != 0 || dup2(stdin_pipe[0], STDIN_FILENO) < 0) {
+        perror("Failed to detach stdin from fork server");
+        exit(1);
+    }
+    // With stdin already closed, pipe() may hand back fd 0 itself
+    if (stdin_pipe[0] != STDIN_FILENO) {
+        close(stdin_pipe[0]);
+    }
+    close(stdin_pipe[1]);
+
+    snprintf(fd_str, sizeof(fd_str), "%d", server_fd);
+    if (setenv(FORKSERVER_FD_ENV, fd_str, 1) != 0) {
+        perror("setenv");
+        exit(1);
+    }
+
+    if (apply_sandbox_restrictions(config) != 0) {
+        exit(1);
+    }
+
+    printf("Restrictions applied, starting fork server: %s\n", config->executable);
+    fflush(stdout);
+
+    execvp(config->executable, config->exec_args);
+    perror("execvp failed");
+    exit(1);
+}
+
+static int report_job(struct sandbox_config *config, int job, const char *reply) {
+    char msg[128];
+    char reason[64];
+    int value;
+
+    if (sscanf(reply, "exit %d", &value) == 1) {
+        printf("Job %d exited with status %d\n", job, value);
+        return value;
+    }
+
+    if (sscanf(reply, "signal %d", &value) == 1) {
+        printf("Job %d killed by signal %d", job, value);
+        if (value == SIGSYS) {
+            printf(" (SIGSYS - seccomp violation)");
+            if (config->has_logfile) {
+                snprintf(msg, sizeof(msg),
+                         "Fork server job %d killed by seccomp - syscall violation detected", job);
+                log_message(config->logfile, msg);
+            }
+        }
+        printf("\n");
+        return 128 + value;
+    }
+
+    if (sscanf(reply, "error %63s", reason) == 1) {
+        printf("Job %d rejected by fork server (%s)\n", job, reason);
+        return -1;
+    }
+
+    fprintf(stderr, "Malformed reply from fork server: %s\n", reply);
+    return -1;
+}
+
+int run_fork_server(struct sandbox_config *config) {
+    int fds[2];
+    char job[MAX_JOB_LEN];
+    char reply[64];
+    int job_count = 0;
+    int failed = 0;
+
+    // A closed stdin would let socketpair() reuse fd 0, and the job loop
+    // would then read the server's replies as jobs; treat it as empty
+    if (fcntl(STDIN_FILENO, F_GETFD) < 0 && open("/dev/null", O_RDONLY) != STDIN_FILENO) {
+        perror("Failed to open /dev/null as stdin");
+        return 1;
+    }
+
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) {
+        perror("socketpair failed");
+        return 1;
+    }
+
+    printf("Forking to create sandboxed fork server...\n");
+    fflush(stdout);
+
+    pid_t pid = fork();
+
+    if (pid == 0) {
+        // Child process - keep only the server end, and let it survive execve
+        close(fds[0]);
+        if (fcntl(fds[1], F_SETFD, 0) != 0) {
+            perror("fcntl");
+            exit(1);
+        }
+        start_server(config, fds[1]);
+    }
+    else if (pid < 0) {
+        perror("fork failed");
+        close(fds[0]);
+        close(fds[1]);
+        return 1;
+    }
+
+    // Parent process - relay jobs from stdin to the server, one at a time
+    close(fds[1]);
+    printf("Fork server started as process %d, reading jobs from stdin...\n", pid);
+
+    while (fgets(job, sizeof(job), stdin) != NULL) {
+        size_t len = strlen(job);
+
+        if (len > 0 && job[len - 1] != '\n') {
+            if (!feof(stdin)) {
+                fprintf(stderr, "Job request too long (max %d bytes), skipping\n", MAX_JOB_LEN - 1);
+                int c;
+                while ((c = getchar()) != EOF && c != '\n') {
+                }
+                failed = 1;
+                continue;
+            }
+            job[len++] = '\n';
+            job[len] = '\0';
+        }
+
+        if (strspn(job, " \t\n") == len) {
+            continue;
+        }
+
+        job_count++;
+        fflush(stdout);
+
+        int reply_len = -1;
+        if (write_all(fds[0], job, len) == 0) {
+            reply_len = read_line(fds[0], reply, sizeof(reply));
+        }
+        if (reply_len == -2) {
+            fprintf(stderr, "Malformed reply from fork server for job %d: too long\n", job_count);
+            failed = 1;
+            continue;
+        }
+        if (reply_len < 0) {
+            fprintf(stderr, "Fork server terminated unexpectedly\n");
+            failed = 1;
+            break;
+        }
+
+        if (report_job(config, job_count, reply) != 0) {
+            failed = 1;
+        }
+    }
+
+    // Closing our end tells the server there are no more jobs
+    close(fds[0]);
+
+    int status;
+    while (waitpid(pid, &status, 0) < 0) {
+        if (errno != EINTR) {
+            perror("waitpid failed");
+            return 1;
+        }
+    }
+
+    if (WIFSIGNALED(status)) {
+        int sig = WTERMSIG(status);
+        printf("Fork server killed by signal %d", sig);
+        if (sig == SIGSYS) {
+            printf(" (SIGSYS - seccomp violation)");
+            if (config->has_logfile) {
+                log_message(config->logfile, "Fork server killed by seccomp - syscall violation detected");
+            }
+        }
+        printf("\n");
+        return 1;
+    }
+
+    printf("Fork server exited with status %d after %d job(s)\n", WEXITSTATUS(status), job_count);
+
+    if (WEXITSTATUS(status) != 0) {
+        return WEXITSTATUS(status);
+    }
+    return failed ? 1 : 0;
+}
@@ -36,9 +36,12 @@ void print_usage(const char *program_name) {
     printf("  --seccomp-block=MODE     Seccomp blocking mode (kill|log|errno)\n");
     printf("                           kill:  Kill process on violation (default)\n");
     printf("                           log:   Log violations but allow syscall\n");
-    printf("                           errno: Return EPERM error\n\n");
+    printf("                           errno: Return EPERM error\n");
+    printf("  --fork-server            Run executable once as a fork server and feed\n");
+    printf("                           it one job per line from stdin\n\n");
     printf("Examples:\n");
     printf("  %s --read=/usr/lib --write=/tmp python3 script.py\n", program_name);
     printf("  %s --seccomp-block=log mpv video.mp4\n", program_name);
     printf("  %s --seccomp-block=errno --read=/home/user python3 -i\n", program_name);
+    printf("  %s --fork-server --read=scripts python3 scripts/forkserver.py warmup.py < jobs\n", program_name);
 }
@@ -48,6 +48,9 @@ int parse_arguments(int argc, char *argv[], struct sandbox_config *config) {
                 return -1;
             }
         }
+        else if (strcmp(argv[i], "--fork-server") == 0) {
+            config->fork_server = 1;
+        }
         else if (argv[i][0] != '-') {
             // This is the executable
             strncpy(config->executable, argv[i], MAX_PATH_LEN - 1);
@@ -70,7 +73,35 @@ int parse_arguments(int argc, char *argv[], struct sandbox_config *config) {
     return 0;
 }
 
+int apply_sandbox_restrictions(struct sandbox_config *config) {
+    if (config->has_logfile) {
+        log_message(config->logfile, "Starting sandboxed execution");
+    }
+
+    // Apply Landlock filesystem restrictions FIRST
+    printf("Setting up Landlock filesystem restrictions...\n");
+    if (setup_landlock(config) != 0) {
+        fprintf(stderr, "Failed to setup Landlock restrictions\n");
+        return -1;
+    }
+
+    // Apply seccomp syscall filtering SECOND
+    printf("Setting up seccomp syscall filtering (mode: %s)...\n",
+           config->seccomp_mode == SECCOMP_MODE_KILL ? "kill" :
+           config->seccomp_mode == SECCOMP_MODE_LOG ? "log" : "errno");
+    if (setup_seccomp(config) != 0) {
+        fprintf(stderr, "Failed to setup seccomp filtering\n");
+        return -1;
+    }
+
+    return 0;
+}
+
 int execute_sandboxed(struct sandbox_config *config) {
+    if (config->fork_server) {
+        return run_fork_server(config);
+    }
+
     printf("Forking to create sandboxed process...\n");
 
     pid_t pid = fork();
@@ -79,23 +110,7 @@ int execute_sandboxed(struct sandbox_config *config) {
         // Child process - apply restrictions and execute the target program
         printf("Child process started, applying restrictions...\n");
 
-        if (config->has_logfile) {
-            log_message(config->logfile, "Starting sandboxed execution");
-        }
-
-        // Apply Landlock filesystem restrictions FIRST
-        printf("Setting up Landlock filesystem restrictions...\n");
-        if (setup_landlock(config) != 0) {
-            fprintf(stderr, "Failed to setup Landlock restrictions\n");
-            exit(1);
-        }
-
-        // Apply seccomp syscall filtering SECOND
-        printf("Setting up seccomp syscall filtering (mode: %s)...\n",
-               config->seccomp_mode == SECCOMP_MODE_KILL ? "kill" :
-               config->seccomp_mode == SECCOMP_MODE_LOG ? "log" : "errno");
-        if (setup_seccomp(config) != 0) {
-            fprintf(stderr, "Failed to setup seccomp filtering\n");
+        if (apply_sandbox_restrictions(config) != 0) {
             exit(1);
         }
 
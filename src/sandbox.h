@@ -17,9 +17,14 @@
 #include <errno.h>
 #include <signal.h>
 #include <sys/wait.h>
+#include <sys/socket.h>
 
 #define MAX_PATHS 256
 #define MAX_PATH_LEN 4096
+#define MAX_JOB_LEN 4096
+
+// Environment variable telling the fork server which fd carries job requests
+#define FORKSERVER_FD_ENV "SANDBOX_FORKSERVER_FD"
 
 // Seccomp blocking modes
 typedef enum {
@@ -65,13 +70,16 @@ struct sandbox_config {
     int exec_count;
     int has_logfile;
     seccomp_block_mode_t seccomp_mode;
+    int fork_server;
 };
 
 // Function declarations
 int parse_arguments(int argc, char *argv[], struct sandbox_config *config);
 int setup_landlock(struct sandbox_config *config);
 int setup_seccomp(struct sandbox_config *config);
+int apply_sandbox_restrictions(struct sandbox_config *config);
 int execute_sandboxed(struct sandbox_config *config);
+int run_fork_server(struct sandbox_config *config);
 void log_message(const char *logfile, const char *message);
 void print_usage(const char *program_name);
 void add_essential_system_paths(struct sandbox_config *config);